@@ -0,0 +1,192 @@
+#include "vm_memory.h"
+
+#define BUDDY_NOT_FREE 0xFF
+#define BUDDY_NOT_ALLOCATED 0xFF
+
+static void buddy_push(BuddyAllocator *ba, uint32_t frame, uint32_t order) {
+    uint32_t head = ba->free_head[order];
+
+    ba->next_free[frame] = head;
+    ba->prev_free[frame] = BUDDY_NO_FRAME;
+    if (head != BUDDY_NO_FRAME) {
+        ba->prev_free[head] = frame;
+    }
+    ba->free_head[order] = frame;
+    ba->free_order[frame] = (uint8_t)order;
+    ba->free_blocks[order]++;
+}
+
+static void buddy_remove(BuddyAllocator *ba, uint32_t frame, uint32_t order) {
+    uint32_t next = ba->next_free[frame];
+    uint32_t prev = ba->prev_free[frame];
+
+    if (prev != BUDDY_NO_FRAME) {
+        ba->next_free[prev] = next;
+    } else {
+        ba->free_head[order] = next;
+    }
+    if (next != BUDDY_NO_FRAME) {
+        ba->prev_free[next] = prev;
+    }
+    ba->free_order[frame] = BUDDY_NOT_FREE;
+    ba->free_blocks[order]--;
+}
+
+void init_buddy_allocator(BuddyAllocator *ba, uint32_t num_frames) {
+    memset(ba, 0, sizeof(BuddyAllocator));
+    ba->num_frames = num_frames;
+    ba->next_free = (uint32_t *)malloc((size_t)num_frames * sizeof(uint32_t));
+    ba->prev_free = (uint32_t *)malloc((size_t)num_frames * sizeof(uint32_t));
+    ba->free_order = (uint8_t *)malloc((size_t)num_frames * sizeof(uint8_t));
+    ba->alloc_order = (uint8_t *)malloc((size_t)num_frames * sizeof(uint8_t));
+
+    if (num_frames == 0 || !ba->next_free || !ba->prev_free || !ba->free_order || !ba->alloc_order) {
+        fprintf(stderr, "Failed to allocate memory for buddy allocator\n");
+        exit(1);
+    }
+
+    memset(ba->free_order, BUDDY_NOT_FREE, num_frames);
+    memset(ba->alloc_order, BUDDY_NOT_ALLOCATED, num_frames);
+    for (uint32_t order = 0; order <= BUDDY_MAX_ORDER; order++) {
+        ba->free_head[order] = BUDDY_NO_FRAME;
+    }
+
+    while (ba->max_order < BUDDY_MAX_ORDER && (2ULL << ba->max_order) <= num_frames) {
+        ba->max_order++;
+    }
+
+    // Carve the frame range into the largest naturally aligned blocks
+    uint64_t start = 0;
+    while (start < num_frames) {
+        uint32_t order = ba->max_order;
+        while ((start & ((1ULL << order) - 1)) != 0 || start + (1ULL << order) > num_frames) {
+            order--;
+        }
+        buddy_push(ba, (uint32_t)start, order);
+        start += 1ULL << order;
+    }
+    ba->free_frames = num_frames;
+
+    printf("Buddy allocator initialized with %u frames (max order %u)\n", num_frames, ba->max_order);
+}
+
+void cleanup_buddy_allocator(BuddyAllocator *ba) {
+    if (ba->next_free) {
+        free(ba->next_free);
+        ba->next_free = NULL;
+    }
+
+    if (ba->prev_free) {
+        free(ba->prev_free);
+        ba->prev_free = NULL;
+    }
+
+    if (ba->free_order) {
+        free(ba->free_order);
+        ba->free_order = NULL;
+    }
+
+    if (ba->alloc_order) {
+        free(ba->alloc_order);
+        ba->alloc_order = NULL;
+    }
+}
+
+uint32_t buddy_alloc(BuddyAllocator *ba, uint32_t order) {
+    // Find the smallest free block that is large enough
+    uint32_t current = order;
+    while (current <= ba->max_order && ba->free_head[current] == BUDDY_NO_FRAME) {
+        current++;
+    }
+
+    if (current > ba->max_order) {
+        ba->failed_allocations++;
+        return BUDDY_NO_FRAME;
+    }
+
+    uint32_t frame = ba->free_head[current];
+    buddy_remove(ba, frame, current);
+
+    // Split down to the requested order, returning the upper halves
+    while (current > order) {
+        current--;
+        buddy_push(ba, frame + (1u << current), current);
+        ba->splits++;
+    }
+
+    ba->alloc_order[frame] = (uint8_t)order;
+    ba->free_frames -= 1u << order;
+    ba->allocations++;
+    return frame;
+}
+
+void buddy_free(BuddyAllocator *ba, uint32_t frame, uint32_t order) {
+    // Only a block returned by buddy_alloc, freed once with its own order,
+    // may go back on the free lists
+    if (frame >= ba->num_frames || order > ba->max_order || ba->alloc_order[frame] != order) {
+        fprintf(stderr, "Invalid buddy free of frame %u at order %u\n", frame, order);
+        return;
+    }
+    ba->alloc_order[frame] = BUDDY_NOT_ALLOCATED;
+
+    ba->free_frames += 1u << order;
+    ba->frees++;
+
+    // Merge with the buddy for as long as it is free at the same order
+    while (order < ba->max_order) {
+        uint32_t buddy = frame ^ (1u << order);
+        if (buddy >= ba->num_frames || ba->free_order[buddy] != order) {
+            break;
+        }
+        buddy_remove(ba, buddy, order);
+        frame &= ~(1u << order);
+        order++;
+        ba->merges++;
+    }
+
+    buddy_push(ba, frame, order);
+}
+
+uint32_t buddy_largest_free_order(BuddyAllocator *ba) {
+    for (uint32_t order = ba->max_order + 1; order > 0; order--) {
+        if (ba->free_blocks[order - 1] > 0) {
+            return order - 1;
+        }
+    }
+    return BUDDY_NO_FRAME;
+}
+
+// Unusable free space index: the fraction of free frames that cannot serve
+// an allocation of the given order. 0 means none, 1 means all of them.
+double buddy_unusable_index(BuddyAllocator *ba, uint32_t order) {
+    if (ba->free_frames == 0) {
+        return 0;
+    }
+
+    uint64_t usable = 0;
+    for (uint32_t k = order; k <= ba->max_order; k++) {
+        usable += (uint64_t)ba->free_blocks[k] << k;
+    }
+    return (double)(ba->free_frames - usable) / ba->free_frames;
+}
+
+void buddy_print_stats(BuddyAllocator *ba) {
+    uint32_t largest = buddy_largest_free_order(ba);
+
+    printf("\nBuddy Allocator Statistics:\n");
+    printf("Frames: %u total, %u free (%.2f%%)\n", ba->num_frames, ba->free_frames,
+           (double)ba->free_frames / ba->num_frames * 100);
+    printf("Allocations: %lu, Frees: %lu, Failed: %lu\n", ba->allocations, ba->frees, ba->failed_allocations);
+    printf("Splits: %lu, Merges: %lu\n", ba->splits, ba->merges);
+    if (largest != BUDDY_NO_FRAME) {
+        printf("Largest Free Block: order %u (%lu frames)\n", largest, 1UL << largest);
+        printf("External Fragmentation: %.2f%%\n",
+               (1.0 - (double)(1UL << largest) / ba->free_frames) * 100);
+    }
+
+    printf("Order | Free Blocks | Unusable Index\n");
+    printf("------|-------------|---------------\n");
+    for (uint32_t order = 0; order <= ba->max_order; order++) {
+        printf("  %2u  |  %9u  |     %.4f\n", order, ba->free_blocks[order], buddy_unusable_index(ba, order));
+    }
+}
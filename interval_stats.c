@@ -0,0 +1,213 @@
+#include "vm_memory.h"
+
+#define INTERVAL_STATS_INITIAL_CAPACITY 64
+
+void init_interval_stats(IntervalStats *is, uint64_t interval_accesses, uint64_t interval_cycles, bool heat_map) {
+    memset(is, 0, sizeof(IntervalStats));
+    is->interval_accesses = interval_accesses;
+    is->interval_cycles = interval_cycles;
+    is->capacity = INTERVAL_STATS_INITIAL_CAPACITY;
+    is->samples = (IntervalSample *)calloc(is->capacity, sizeof(IntervalSample));
+    is->page_epoch = (uint32_t *)calloc(NUM_PAGES, sizeof(uint32_t));
+    is->page_access_counts = heat_map ? (uint32_t *)calloc(NUM_PAGES, sizeof(uint32_t)) : NULL;
+
+    if (!is->samples || !is->page_epoch || (heat_map && !is->page_access_counts)) {
+        fprintf(stderr, "Failed to allocate memory for interval statistics\n");
+        exit(1);
+    }
+
+    printf("Interval statistics initialized (every %lu accesses, every %lu cycles, heat map %s)\n",
+           interval_accesses, interval_cycles, heat_map ? "on" : "off");
+}
+
+void cleanup_interval_stats(IntervalStats *is) {
+    if (is->samples) {
+        free(is->samples);
+        is->samples = NULL;
+    }
+
+    if (is->page_epoch) {
+        free(is->page_epoch);
+        is->page_epoch = NULL;
+    }
+
+    if (is->page_access_counts) {
+        free(is->page_access_counts);
+        is->page_access_counts = NULL;
+    }
+}
+
+static void interval_stats_reset_window(IntervalStats *is, MMU *mmu) {
+    is->window_accesses = 0;
+    is->window_working_set = 0;
+    is->base_tlb_hits = mmu->tlb.hits;
+    is->base_tlb_misses = mmu->tlb.misses;
+    is->base_page_walks = mmu->page_table.accesses;
+    is->base_page_faults = mmu->page_table.faults;
+    is->base_cycles = mmu->total_cycles;
+}
+
+static void interval_stats_snapshot(IntervalStats *is, MMU *mmu) {
+    if (is->num_samples == is->capacity) {
+        uint32_t new_capacity = is->capacity * 2;
+        IntervalSample *samples = (IntervalSample *)realloc(is->samples, new_capacity * sizeof(IntervalSample));
+        if (!samples) {
+            fprintf(stderr, "Failed to grow interval statistics buffer\n");
+            exit(1);
+        }
+        is->samples = samples;
+        is->capacity = new_capacity;
+    }
+
+    IntervalSample *sample = &is->samples[is->num_samples];
+    sample->interval_index = is->num_samples;
+    sample->first_access = is->total_accesses - is->window_accesses;
+    sample->accesses = is->window_accesses;
+    sample->tlb_hits = mmu->tlb.hits - is->base_tlb_hits;
+    sample->tlb_misses = mmu->tlb.misses - is->base_tlb_misses;
+    sample->page_walks = mmu->page_table.accesses - is->base_page_walks;
+    sample->page_faults = mmu->page_table.faults - is->base_page_faults;
+    sample->cycles = mmu->total_cycles - is->base_cycles;
+    sample->working_set_pages = is->window_working_set;
+    sample->tlb_hit_rate = sample->accesses > 0 ? (double)sample->tlb_hits / sample->accesses * 100 : 0;
+    sample->avg_access_time = sample->accesses > 0 ? (double)sample->cycles / sample->accesses : 0;
+    is->num_samples++;
+
+    interval_stats_reset_window(is, mmu);
+
+    // A single page fault may span several cycle intervals
+    if (is->interval_cycles > 0) {
+        while (is->next_cycle_boundary <= mmu->total_cycles) {
+            is->next_cycle_boundary += is->interval_cycles;
+        }
+    }
+}
+
+void interval_stats_begin(IntervalStats *is, MMU *mmu) {
+    interval_stats_reset_window(is, mmu);
+
+    // Boundaries of zero-length intervals are never reached
+    is->window_access_limit = is->interval_accesses > 0 ? is->interval_accesses : UINT64_MAX;
+    is->next_cycle_boundary = is->interval_cycles > 0 ? mmu->total_cycles + is->interval_cycles : UINT64_MAX;
+}
+
+void interval_stats_record(IntervalStats *is, MMU *mmu, uint32_t virtual_page, uint64_t count) {
+    // Epochs start at 1 so a zeroed entry never matches the current interval
+    uint32_t epoch = is->num_samples + 1;
+    if (is->page_epoch[virtual_page] != epoch) {
+        is->page_epoch[virtual_page] = epoch;
+        is->window_working_set++;
+    }
+
+    if (is->page_access_counts) {
+        is->page_access_counts[virtual_page] += count;
+    }
+
+    is->total_accesses += count;
+    is->window_accesses += count;
+
+    if (is->window_accesses >= is->window_access_limit || mmu->total_cycles >= is->next_cycle_boundary) {
+        interval_stats_snapshot(is, mmu);
+    }
+}
+
+// Number of back-to-back TLB hits that can be recorded as one batch without
+// stepping past the next interval boundary. Always at least 1.
+uint64_t interval_stats_hit_budget(IntervalStats *is, MMU *mmu) {
+    uint64_t access_budget = is->window_access_limit - is->window_accesses;
+    uint64_t cycle_budget = (is->next_cycle_boundary - mmu->total_cycles - 1) / TLB_HIT_TIME + 1;
+    return access_budget < cycle_budget ? access_budget : cycle_budget;
+}
+
+void interval_stats_finish(IntervalStats *is, MMU *mmu) {
+    // Flush the trailing partial interval
+    if (is->window_accesses > 0) {
+        interval_stats_snapshot(is, mmu);
+    }
+}
+
+void interval_stats_print(IntervalStats *is) {
+    printf("\nInterval | First Access | Accesses | TLB Hit Rate | Walks  | Faults | Avg Access Time | Working Set\n");
+    printf("---------|--------------|----------|--------------|--------|--------|-----------------|------------\n");
+
+    for (uint32_t i = 0; i < is->num_samples; i++) {
+        IntervalSample *sample = &is->samples[i];
+        printf("  %5lu  |  %10lu  |  %6lu  |    %6.2f%%   | %6lu | %6lu |     %8.2f    |   %6u\n",
+               sample->interval_index, sample->first_access, sample->accesses, sample->tlb_hit_rate,
+               sample->page_walks, sample->page_faults, sample->avg_access_time, sample->working_set_pages);
+    }
+}
+
+void interval_stats_export_csv(IntervalStats *is, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Failed to open file %s for writing\n", filename);
+        return;
+    }
+
+    fprintf(file, "interval,first_access,accesses,tlb_hits,tlb_misses,tlb_hit_rate,"
+                  "page_walks,page_faults,cycles,avg_access_time,working_set_pages\n");
+    for (uint32_t i = 0; i < is->num_samples; i++) {
+        IntervalSample *sample = &is->samples[i];
+        fprintf(file, "%lu,%lu,%lu,%lu,%lu,%.4f,%lu,%lu,%lu,%.4f,%u\n",
+                sample->interval_index, sample->first_access, sample->accesses,
+                sample->tlb_hits, sample->tlb_misses, sample->tlb_hit_rate,
+                sample->page_walks, sample->page_faults, sample->cycles,
+                sample->avg_access_time, sample->working_set_pages);
+    }
+
+    fclose(file);
+    printf("Saved %u interval samples to %s\n", is->num_samples, filename);
+}
+
+void interval_stats_export_json(IntervalStats *is, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Failed to open file %s for writing\n", filename);
+        return;
+    }
+
+    fprintf(file, "{\n  \"interval_accesses\": %lu,\n  \"interval_cycles\": %lu,\n  \"samples\": [",
+            is->interval_accesses, is->interval_cycles);
+    for (uint32_t i = 0; i < is->num_samples; i++) {
+        IntervalSample *sample = &is->samples[i];
+        fprintf(file, "%s\n    {\"interval\": %lu, \"first_access\": %lu, \"accesses\": %lu, "
+                      "\"tlb_hits\": %lu, \"tlb_misses\": %lu, \"tlb_hit_rate\": %.4f, "
+                      "\"page_walks\": %lu, \"page_faults\": %lu, \"cycles\": %lu, "
+                      "\"avg_access_time\": %.4f, \"working_set_pages\": %u}",
+                i > 0 ? "," : "", sample->interval_index, sample->first_access, sample->accesses,
+                sample->tlb_hits, sample->tlb_misses, sample->tlb_hit_rate,
+                sample->page_walks, sample->page_faults, sample->cycles,
+                sample->avg_access_time, sample->working_set_pages);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    fclose(file);
+    printf("Saved %u interval samples to %s\n", is->num_samples, filename);
+}
+
+void interval_stats_export_heat_map(IntervalStats *is, const char *filename) {
+    if (!is->page_access_counts) {
+        fprintf(stderr, "Heat map was not enabled for this collector\n");
+        return;
+    }
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Failed to open file %s for writing\n", filename);
+        return;
+    }
+
+    // Only pages that were referenced at least once are written
+    uint32_t pages = 0;
+    fprintf(file, "page,accesses\n");
+    for (uint32_t page = 0; page < NUM_PAGES; page++) {
+        if (is->page_access_counts[page] > 0) {
+            fprintf(file, "0x%05X,%u\n", page, is->page_access_counts[page]);
+            pages++;
+        }
+    }
+
+    fclose(file);
+    printf("Saved heat map of %u pages to %s\n", pages, filename);
+}
@@ -38,6 +38,37 @@ void test_simple_page_table() {
     cleanup_simple_page_table(&pt);
 }
 
+void test_sparse_simple_page_table() {
+    printf("\n=== Sparse Simple Page Table Test ===\n");
+    
+    // Many concurrent flat tables, each touching a few hundred random pages
+    const int num_tables = 32;
+    const int touches_per_table = 500;
+    SimplePageTable tables[32];
+    
+    for (int t = 0; t < num_tables; t++) {
+        init_simple_page_table_sparse(&tables[t]);
+        for (int i = 0; i < touches_per_table; i++) {
+            bool fault;
+            translate_simple_page_table(&tables[t], (uint32_t)rand() * 2u, &fault);
+        }
+    }
+    
+    size_t resident = 0;
+    for (int t = 0; t < num_tables; t++) {
+        resident += simple_page_table_resident_bytes(&tables[t]);
+    }
+    size_t dense = (size_t)num_tables * NUM_PAGES * sizeof(PageTableEntry);
+    
+    printf("Tables: %d, Pages touched per table: %d\n", num_tables, touches_per_table);
+    printf("Dense footprint:  %zu KB\n", dense / 1024);
+    printf("Sparse resident:  %zu KB (%.2f%%)\n", resident / 1024, (double)resident / dense * 100);
+    
+    for (int t = 0; t < num_tables; t++) {
+        cleanup_simple_page_table(&tables[t]);
+    }
+}
+
 void test_two_level_page_table() {
     printf("\n=== Two-Level Page Table Test ===\n");
     
@@ -149,6 +180,321 @@ void test_mmu_performance() {
     free(addresses);
 }
 
+void test_interval_statistics() {
+    printf("\n=== Interval Statistics Test ===\n");
+    
+    const int num_accesses = 20000;
+    uint32_t *addresses = (uint32_t *)malloc(num_accesses * sizeof(uint32_t));
+    if (!addresses) {
+        fprintf(stderr, "Failed to allocate memory for addresses\n");
+        return;
+    }
+    
+    MMU mmu;
+    init_mmu(&mmu);
+    
+    IntervalStats intervals;
+    init_interval_stats(&intervals, 2500, 0, true);
+    mmu.interval_stats = &intervals;
+    
+    // Sequential phase followed by a scattered phase shows up as a fault burst
+    generate_address_trace(addresses, num_accesses / 2, 1);
+    generate_address_trace(addresses + num_accesses / 2, num_accesses / 2, 2);
+    
+    MemoryStats stats;
+    run_simulation(&mmu, addresses, num_accesses, &stats);
+    
+    interval_stats_print(&intervals);
+    interval_stats_export_csv(&intervals, "interval_stats.csv");
+    interval_stats_export_json(&intervals, "interval_stats.json");
+    interval_stats_export_heat_map(&intervals, "page_heat_map.csv");
+    
+    cleanup_interval_stats(&intervals);
+    cleanup_mmu(&mmu);
+    free(addresses);
+}
+
+void test_page_run_coalescing() {
+    printf("\n=== Same-Page Run Coalescing Test ===\n");
+    
+    const int num_accesses = 200000;
+    uint32_t *addresses = (uint32_t *)malloc(num_accesses * sizeof(uint32_t));
+    if (!addresses) {
+        fprintf(stderr, "Failed to allocate memory for addresses\n");
+        return;
+    }
+    
+    generate_address_trace(addresses, num_accesses, 1);
+    
+    MMU mmu;
+    MemoryStats stats_per_reference, stats_coalesced;
+    
+    init_mmu(&mmu);
+    clock_t start = clock();
+    run_simulation(&mmu, addresses, num_accesses, &stats_per_reference);
+    double per_reference_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    cleanup_mmu(&mmu);
+    
+    init_mmu(&mmu);
+    mmu.coalesce_page_runs = true;
+    start = clock();
+    run_simulation(&mmu, addresses, num_accesses, &stats_coalesced);
+    double coalesced_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    cleanup_mmu(&mmu);
+    
+    bool identical = stats_per_reference.tlb_hits == stats_coalesced.tlb_hits &&
+                     stats_per_reference.tlb_misses == stats_coalesced.tlb_misses &&
+                     stats_per_reference.page_faults == stats_coalesced.page_faults &&
+                     stats_per_reference.total_cycles == stats_coalesced.total_cycles;
+    
+    printf("Per-reference replay: %.4f s\n", per_reference_time);
+    printf("Coalesced replay:     %.4f s\n", coalesced_time);
+    printf("Statistics identical: %s\n", identical ? "yes" : "NO");
+    
+    free(addresses);
+}
+
+void test_tlb_reach() {
+    printf("\n=== Coalesced and Range TLB Reach Test ===\n");
+    
+    // Two sweeps over a 64-page buffer, four references per page. The first
+    // sweep faults the pages in, the second measures how many still hit.
+    const int num_pages = 64;
+    const int refs_per_page = 4;
+    const int num_accesses = 2 * num_pages * refs_per_page;
+    uint32_t *addresses = (uint32_t *)malloc(num_accesses * sizeof(uint32_t));
+    if (!addresses) {
+        fprintf(stderr, "Failed to allocate memory for addresses\n");
+        return;
+    }
+    
+    for (int i = 0; i < num_accesses; i++) {
+        addresses[i] = 0x10000000 + (i % (num_pages * refs_per_page)) * (PAGE_SIZE / refs_per_page);
+    }
+    
+    const char *names[] = {"Baseline", "Coalesced (8)", "Range TLB"};
+    MemoryStats stats[3];
+    uint64_t walks[3];
+    uint64_t range_hits[3];
+    
+    for (int config = 0; config < 3; config++) {
+        MMU mmu;
+        init_mmu(&mmu);
+        if (config == 1) {
+            tlb_set_coalescing(&mmu.tlb, 8);
+        } else if (config == 2) {
+            init_range_tlb(&mmu.range_tlb, RANGE_TLB_SIZE);
+        }
+        
+        run_simulation(&mmu, addresses, num_accesses, &stats[config]);
+        walks[config] = mmu.page_table.accesses;
+        range_hits[config] = mmu.range_tlb.hits;
+        
+        if (config == 1) {
+            tlb_print_contents(&mmu.tlb);
+        }
+        cleanup_mmu(&mmu);
+    }
+    
+    printf("Configuration     | TLB Hit Rate | Page Walks | Range Hits | Avg Access Time\n");
+    printf("------------------|--------------|------------|------------|----------------\n");
+    for (int config = 0; config < 3; config++) {
+        printf("%-17s |    %6.2f%%   |   %6lu   |   %6lu   |     %8.2f\n",
+               names[config], stats[config].tlb_hit_rate, walks[config],
+               range_hits[config], stats[config].avg_access_time);
+    }
+    
+    free(addresses);
+}
+
+void test_buddy_allocator() {
+    printf("\n=== Buddy Frame Allocator Test ===\n");
+    
+    // Fragment 4GB of simulated RAM by freeing every other small block
+    const int num_blocks = 100000;
+    uint32_t *frames = (uint32_t *)malloc(num_blocks * sizeof(uint32_t));
+    if (!frames) {
+        fprintf(stderr, "Failed to allocate memory for frame list\n");
+        return;
+    }
+    
+    BuddyAllocator buddy;
+    init_buddy_allocator(&buddy, 1u << PAGE_NUMBER_BITS);
+    
+    clock_t start = clock();
+    for (int i = 0; i < num_blocks; i++) {
+        frames[i] = buddy_alloc(&buddy, i % 4);
+    }
+    for (int i = 0; i < num_blocks; i += 2) {
+        buddy_free(&buddy, frames[i], i % 4);
+    }
+    printf("%d allocations and %d frees in %.4f s\n", num_blocks, num_blocks / 2,
+           (double)(clock() - start) / CLOCKS_PER_SEC);
+    buddy_print_stats(&buddy);
+    cleanup_buddy_allocator(&buddy);
+    free(frames);
+    
+    // Two sweeps over 512 pages: the 256-frame round-robin pool wraps, so
+    // pairs of pages alias one frame, while the buddy allocator gives every
+    // page its own frame and still keeps the run contiguous
+    const int num_pages = 512;
+    const int num_accesses = 2 * num_pages;
+    uint32_t *addresses = (uint32_t *)malloc(num_accesses * sizeof(uint32_t));
+    if (!addresses) {
+        fprintf(stderr, "Failed to allocate memory for addresses\n");
+        return;
+    }
+    for (int i = 0; i < num_accesses; i++) {
+        addresses[i] = 0x20000000 + (i % num_pages) * PAGE_SIZE;
+    }
+    
+    MemoryStats stats_round_robin, stats_buddy;
+    MMU mmu;
+    
+    init_mmu(&mmu);
+    init_range_tlb(&mmu.range_tlb, RANGE_TLB_SIZE);
+    run_simulation(&mmu, addresses, num_accesses, &stats_round_robin);
+    uint64_t range_hits_round_robin = mmu.range_tlb.hits;
+    cleanup_mmu(&mmu);
+    
+    init_buddy_allocator(&buddy, 1u << PAGE_NUMBER_BITS);
+    init_mmu(&mmu);
+    init_range_tlb(&mmu.range_tlb, RANGE_TLB_SIZE);
+    mmu_attach_frame_allocator(&mmu, &buddy);
+    run_simulation(&mmu, addresses, num_accesses, &stats_buddy);
+    uint64_t range_hits_buddy = mmu.range_tlb.hits;
+    uint64_t frames_buddy = buddy.allocations;
+    cleanup_mmu(&mmu);
+    cleanup_buddy_allocator(&buddy);
+    
+    uint64_t frames_round_robin = stats_round_robin.page_faults < NUM_PHYSICAL_FRAMES ?
+                                  stats_round_robin.page_faults : NUM_PHYSICAL_FRAMES;
+    
+    printf("Frame Allocator   | Frames Used | Range TLB Hits | Avg Access Time\n");
+    printf("------------------|-------------|----------------|----------------\n");
+    printf("Round-robin (256) |   %7lu   |     %6lu     |     %8.2f\n",
+           frames_round_robin, range_hits_round_robin, stats_round_robin.avg_access_time);
+    printf("Buddy (4GB)       |   %7lu   |     %6lu     |     %8.2f\n",
+           frames_buddy, range_hits_buddy, stats_buddy.avg_access_time);
+    
+    free(addresses);
+}
+
+void test_software_refill() {
+    printf("\n=== Software-Managed TLB Refill Test ===\n");
+    
+    // Random references over a 1024-page working set, well beyond TLB reach
+    const int num_accesses = 20000;
+    const uint32_t working_set_pages = 1024;
+    uint32_t *addresses = (uint32_t *)malloc(num_accesses * sizeof(uint32_t));
+    if (!addresses) {
+        fprintf(stderr, "Failed to allocate memory for addresses\n");
+        return;
+    }
+    for (int i = 0; i < num_accesses; i++) {
+        addresses[i] = 0x30000000 + (uint32_t)rand() % (working_set_pages * PAGE_SIZE);
+    }
+    
+    const char *names[] = {"Hardware walk", "SW linear", "SW hashed", "SW TSB"};
+    TLBRefillHandler handlers[] = {NULL, sw_refill_linear, sw_refill_hashed, sw_refill_tsb};
+    uint32_t table_sizes[] = {0, 0, SW_HASH_BUCKETS, SW_TSB_SIZE};
+    MemoryStats stats[4];
+    SoftwareRefill refill[4];
+    
+    for (int config = 0; config < 4; config++) {
+        MMU mmu;
+        init_mmu(&mmu);
+        if (handlers[config]) {
+            mmu_set_software_refill(&mmu, handlers[config], names[config], table_sizes[config]);
+        }
+        
+        run_simulation(&mmu, addresses, num_accesses, &stats[config]);
+        refill[config] = mmu.sw_refill;
+        refill[config].table = NULL;
+        
+        if (config == 3) {
+            mmu_print_stats(&mmu);
+        }
+        cleanup_mmu(&mmu);
+    }
+    
+    printf("\nRefill Mode   | Avg Access Time | Trap Cycles | Handler Instr | Table Hits\n");
+    printf("--------------|-----------------|-------------|---------------|-----------\n");
+    for (int config = 0; config < 4; config++) {
+        printf("%-13s |     %8.2f    |  %9lu  |   %9lu   |  %8lu\n",
+               names[config], stats[config].avg_access_time, refill[config].trap_cycles,
+               refill[config].handler_instructions, refill[config].table_hits);
+    }
+    
+    free(addresses);
+}
+
+void test_pipelined_replay() {
+    printf("\n=== Pipelined Trace Replay Test ===\n");
+    
+    int num_accesses = 1000000;
+    uint32_t *addresses = (uint32_t *)malloc(num_accesses * sizeof(uint32_t));
+    if (!addresses) {
+        fprintf(stderr, "Failed to allocate memory for addresses\n");
+        return;
+    }
+    
+    generate_address_trace(addresses, num_accesses, 2);
+    save_addresses_to_file(addresses, num_accesses, "pipeline_trace.txt");
+    save_addresses_to_binary_file(addresses, num_accesses, "pipeline_trace.bin");
+    
+    MMU mmu;
+    MemoryStats stats_serial, stats_text, stats_binary, stats_generated;
+    TracePipelineStats pipeline_text, pipeline_binary, pipeline_generated;
+    
+    // Serial baseline: load the whole file, then simulate
+    init_mmu(&mmu);
+    double start = wall_clock_seconds();
+    load_addresses_from_file(addresses, &num_accesses, "pipeline_trace.txt");
+    run_simulation(&mmu, addresses, num_accesses, &stats_serial);
+    double serial_time = wall_clock_seconds() - start;
+    cleanup_mmu(&mmu);
+    
+    TraceSource text_source = {TRACE_SOURCE_TEXT, "pipeline_trace.txt", 0, 0, 0};
+    init_mmu(&mmu);
+    run_simulation_pipelined(&mmu, &text_source, &stats_text, &pipeline_text);
+    cleanup_mmu(&mmu);
+    print_pipeline_statistics(&pipeline_text);
+    
+    TraceSource binary_source = {TRACE_SOURCE_BINARY, "pipeline_trace.bin", 0, 0, 0};
+    init_mmu(&mmu);
+    run_simulation_pipelined(&mmu, &binary_source, &stats_binary, &pipeline_binary);
+    cleanup_mmu(&mmu);
+    
+    TraceSource generated_source = {TRACE_SOURCE_GENERATED, NULL, 2, 12345, (uint64_t)num_accesses};
+    init_mmu(&mmu);
+    run_simulation_pipelined(&mmu, &generated_source, &stats_generated, &pipeline_generated);
+    cleanup_mmu(&mmu);
+    
+    bool identical = stats_serial.tlb_hits == stats_text.tlb_hits &&
+                     stats_serial.page_faults == stats_text.page_faults &&
+                     stats_serial.total_cycles == stats_text.total_cycles &&
+                     stats_text.total_cycles == stats_binary.total_cycles;
+    
+    printf("Replay Mode       | Decode (s) | Simulate (s) | Total (s) | Stalls P/C\n");
+    printf("------------------|------------|--------------|-----------|-----------\n");
+    printf("Serial text       |      -     |       -      |  %7.4f  |     -\n", serial_time);
+    printf("Pipelined text    |   %7.4f  |    %7.4f   |  %7.4f  | %lu/%lu\n",
+           pipeline_text.decode_seconds, pipeline_text.simulate_seconds, pipeline_text.wall_seconds,
+           pipeline_text.producer_stalls, pipeline_text.consumer_stalls);
+    printf("Pipelined binary  |   %7.4f  |    %7.4f   |  %7.4f  | %lu/%lu\n",
+           pipeline_binary.decode_seconds, pipeline_binary.simulate_seconds, pipeline_binary.wall_seconds,
+           pipeline_binary.producer_stalls, pipeline_binary.consumer_stalls);
+    printf("Pipelined gen.    |   %7.4f  |    %7.4f   |  %7.4f  | %lu/%lu\n",
+           pipeline_generated.decode_seconds, pipeline_generated.simulate_seconds, pipeline_generated.wall_seconds,
+           pipeline_generated.producer_stalls, pipeline_generated.consumer_stalls);
+    printf("Text/binary statistics match serial replay: %s\n", identical ? "yes" : "NO");
+    
+    remove("pipeline_trace.txt");
+    remove("pipeline_trace.bin");
+    free(addresses);
+}
+
 void experiment_tlb_size_impact() {
     printf("\n=== TLB Size Impact Experiment ===\n");
     
@@ -193,9 +539,16 @@ int main() {
     // Run all tests
     test_address_translation();
     test_simple_page_table();
+    test_sparse_simple_page_table();
     test_two_level_page_table();
     test_tlb();
     test_mmu_performance();
+    test_interval_statistics();
+    test_page_run_coalescing();
+    test_tlb_reach();
+    test_buddy_allocator();
+    test_software_refill();
+    test_pipelined_replay();
     experiment_tlb_size_impact();
     
     printf("\n=== All tests completed successfully ===\n");
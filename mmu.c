@@ -2,12 +2,17 @@
 
 void init_mmu(MMU *mmu) {
     init_tlb(&mmu->tlb);
+    memset(&mmu->range_tlb, 0, sizeof(RangeTLB)); // Disabled until init_range_tlb
     init_two_level_page_table(&mmu->page_table);
     
     mmu->physical_memory = (uint32_t *)calloc(NUM_PHYSICAL_FRAMES * PAGE_SIZE / sizeof(uint32_t), sizeof(uint32_t));
     mmu->frame_allocated = (bool *)calloc(NUM_PHYSICAL_FRAMES, sizeof(bool));
     mmu->next_free_frame = 0;
     mmu->total_cycles = 0;
+    mmu->interval_stats = NULL;
+    mmu->coalesce_page_runs = false;
+    mmu->refill_mode = TLB_REFILL_HARDWARE;
+    memset(&mmu->sw_refill, 0, sizeof(SoftwareRefill));
     
     if (!mmu->physical_memory || !mmu->frame_allocated) {
         fprintf(stderr, "Failed to allocate physical memory simulation\n");
@@ -19,6 +24,8 @@ void init_mmu(MMU *mmu) {
 
 void cleanup_mmu(MMU *mmu) {
     cleanup_tlb(&mmu->tlb);
+    cleanup_range_tlb(&mmu->range_tlb);
+    cleanup_software_refill(&mmu->sw_refill);
     cleanup_two_level_page_table(&mmu->page_table);
     
     if (mmu->physical_memory) {
@@ -32,6 +39,81 @@ void cleanup_mmu(MMU *mmu) {
     }
 }
 
+// Fill the TLB after a miss. In coalesced mode, neighbouring pages of the
+// aligned group whose frames continue the same contiguous run are added to
+// the entry's bitmap.
+static void mmu_fill_tlb(MMU *mmu, uint32_t virtual_page, uint32_t physical_frame) {
+    uint32_t span = mmu->tlb.coalesce_span;
+    if (span == 1) {
+        tlb_insert(&mmu->tlb, virtual_page, physical_frame);
+        return;
+    }
+    
+    uint32_t group_base = virtual_page & ~(span - 1);
+    uint32_t base_frame = physical_frame - (virtual_page - group_base);
+    uint32_t bitmap = 0;
+    
+    for (uint32_t i = 0; i < span; i++) {
+        uint32_t frame;
+        if (group_base + i == virtual_page ||
+            (two_level_page_table_probe(&mmu->page_table, group_base + i, &frame) && frame == base_frame + i)) {
+            bitmap |= 1u << i;
+        }
+    }
+    
+    tlb_insert_coalesced(&mmu->tlb, virtual_page, physical_frame, bitmap);
+}
+
+// Record the contiguous segment around a freshly walked page in the range TLB,
+// where it merges with any entry already holding part of the same segment
+static void mmu_fill_range_tlb(MMU *mmu, uint32_t virtual_page, uint32_t physical_frame) {
+    uint32_t first = virtual_page;
+    uint32_t last = virtual_page;
+    uint32_t frame;
+    
+    while (virtual_page - first < RANGE_TLB_MAX_SCAN && first > 0 &&
+           two_level_page_table_probe(&mmu->page_table, first - 1, &frame) &&
+           frame == physical_frame - (virtual_page - first) - 1) {
+        first--;
+    }
+    
+    while (last - virtual_page < RANGE_TLB_MAX_SCAN && last < PAGE_NUMBER_MASK &&
+           two_level_page_table_probe(&mmu->page_table, last + 1, &frame) &&
+           frame == physical_frame + (last - virtual_page) + 1) {
+        last++;
+    }
+    
+    // Single pages are already covered by the regular TLB
+    if (last > first) {
+        range_tlb_insert(&mmu->range_tlb, first, last - first + 1, physical_frame - (virtual_page - first));
+    }
+}
+
+// Take a TLB refill trap into the software handler. Trap entry/exit and
+// handler instructions are charged separately from the page fault itself.
+static uint32_t mmu_software_refill(MMU *mmu, uint32_t virtual_addr) {
+    SoftwareRefill *sw = &mmu->sw_refill;
+    bool page_fault = false;
+    uint32_t instructions = 0;
+    
+    uint32_t physical_frame = sw->handler(mmu, virtual_addr, &page_fault, &instructions);
+    uint64_t handler_cycles = (uint64_t)instructions * SW_HANDLER_CYCLES_PER_INSTRUCTION;
+    
+    sw->traps++;
+    sw->trap_cycles += SW_TRAP_ENTRY_TIME + SW_TRAP_EXIT_TIME;
+    sw->handler_instructions += instructions;
+    sw->handler_cycles += handler_cycles;
+    
+    mmu->total_cycles += SW_TRAP_ENTRY_TIME + handler_cycles + SW_TRAP_EXIT_TIME;
+    if (page_fault) {
+        mmu->total_cycles += PAGE_FAULT_TIME;
+    }
+    
+    // The handler's final step writes the translation into the TLB
+    mmu_fill_tlb(mmu, get_page_number(virtual_addr), physical_frame);
+    return physical_frame;
+}
+
 uint32_t mmu_translate(MMU *mmu, uint32_t virtual_addr) {
     uint32_t virtual_page = get_page_number(virtual_addr);
     uint32_t page_offset = get_page_offset(virtual_addr);
@@ -44,7 +126,23 @@ uint32_t mmu_translate(MMU *mmu, uint32_t virtual_addr) {
         return (physical_frame << PAGE_OFFSET_BITS) | page_offset;
     }
     
-    // TLB miss, check page table
+    // TLB miss, the range TLB is hardware and is checked before a walk or trap
+    if (mmu->range_tlb.size > 0 && range_tlb_lookup(&mmu->range_tlb, virtual_page, &physical_frame)) {
+        mmu->total_cycles += RANGE_TLB_HIT_TIME;
+        mmu_fill_tlb(mmu, virtual_page, physical_frame);
+        return (physical_frame << PAGE_OFFSET_BITS) | page_offset;
+    }
+    
+    // In software-managed mode the miss traps to the refill handler
+    if (mmu->refill_mode == TLB_REFILL_SOFTWARE) {
+        physical_frame = mmu_software_refill(mmu, virtual_addr);
+        if (mmu->range_tlb.size > 0) {
+            mmu_fill_range_tlb(mmu, virtual_page, physical_frame);
+        }
+        return (physical_frame << PAGE_OFFSET_BITS) | page_offset;
+    }
+    
+    // Check page table
     bool page_fault;
     uint32_t physical_addr = translate_two_level_page_table(&mmu->page_table, virtual_addr, &page_fault);
     
@@ -54,19 +152,44 @@ uint32_t mmu_translate(MMU *mmu, uint32_t virtual_addr) {
         physical_frame = get_page_number(physical_addr);
         
         // Insert into TLB after page fault handling
-        tlb_insert(&mmu->tlb, virtual_page, physical_frame);
+        mmu_fill_tlb(mmu, virtual_page, physical_frame);
     } else {
         // Page table hit
         mmu->total_cycles += PAGE_TABLE_ACCESS_TIME;
         physical_frame = get_page_number(physical_addr);
         
         // Insert into TLB
-        tlb_insert(&mmu->tlb, virtual_page, physical_frame);
+        mmu_fill_tlb(mmu, virtual_page, physical_frame);
+    }
+    
+    if (mmu->range_tlb.size > 0) {
+        mmu_fill_range_tlb(mmu, virtual_page, physical_frame);
     }
     
     return physical_addr;
 }
 
+// Charge `count` further references to the page just translated by
+// mmu_translate. That page is guaranteed to be resident in the TLB, so each
+// reference is a TLB hit and the replacement state does not change.
+void mmu_extend_tlb_hit(MMU *mmu, uint64_t count) {
+    tlb_record_hits(&mmu->tlb, count);
+    mmu->total_cycles += count * TLB_HIT_TIME;
+}
+
+// Take page frames from a buddy allocator instead of the fixed round-robin
+// pool. Physical addresses are 32 bits, so at most 2^20 frames are usable.
+void mmu_attach_frame_allocator(MMU *mmu, BuddyAllocator *allocator) {
+    if (allocator->num_frames > (1u << PAGE_NUMBER_BITS)) {
+        fprintf(stderr, "Frame allocator has %u frames, only %u are addressable\n",
+                allocator->num_frames, 1u << PAGE_NUMBER_BITS);
+        return;
+    }
+    
+    mmu->page_table.frame_allocator = allocator;
+    printf("MMU using buddy allocator with %u frames\n", allocator->num_frames);
+}
+
 uint32_t allocate_physical_frame(MMU *mmu) {
     // Simple round-robin frame allocation
     uint32_t frame = mmu->next_free_frame % NUM_PHYSICAL_FRAMES;
@@ -83,6 +206,30 @@ void mmu_print_stats(MMU *mmu) {
     printf("TLB Hit Rate: %.2f%%\n", 
            mmu->tlb.accesses > 0 ? (double)mmu->tlb.hits / mmu->tlb.accesses * 100 : 0);
     
+    if (mmu->tlb.coalesce_span > 1) {
+        printf("TLB Coalescing Span: %u pages\n", mmu->tlb.coalesce_span);
+        printf("TLB Coalesced Fills: %lu\n", mmu->tlb.coalesced_fills);
+    }
+    
+    if (mmu->range_tlb.size > 0) {
+        printf("Range TLB Accesses: %lu\n", mmu->range_tlb.accesses);
+        printf("Range TLB Hits: %lu\n", mmu->range_tlb.hits);
+        printf("Range TLB Hit Rate: %.2f%%\n",
+               mmu->range_tlb.accesses > 0 ? (double)mmu->range_tlb.hits / mmu->range_tlb.accesses * 100 : 0);
+    }
+    
+    if (mmu->refill_mode == TLB_REFILL_SOFTWARE) {
+        SoftwareRefill *sw = &mmu->sw_refill;
+        printf("Software Refill Handler: %s\n", sw->handler_name);
+        printf("Refill Traps: %lu\n", sw->traps);
+        printf("Trap Entry/Exit Cycles: %lu\n", sw->trap_cycles);
+        printf("Handler Instructions: %lu\n", sw->handler_instructions);
+        printf("Handler Cycles: %lu\n", sw->handler_cycles);
+        if (sw->table_size > 0) {
+            printf("Handler Table Hits: %lu, Misses: %lu\n", sw->table_hits, sw->table_misses);
+        }
+    }
+    
     printf("Page Table Accesses: %lu\n", mmu->page_table.accesses);
     printf("Page Table Hits: %lu\n", mmu->page_table.hits);
     printf("Page Faults: %lu\n", mmu->page_table.faults);
@@ -0,0 +1,90 @@
+#include "vm_memory.h"
+
+void init_range_tlb(RangeTLB *rtlb, uint32_t size) {
+    rtlb->size = size;
+    rtlb->entries = (RangeTLBEntry *)calloc(rtlb->size, sizeof(RangeTLBEntry));
+    rtlb->next_replace = 0;
+    rtlb->accesses = 0;
+    rtlb->hits = 0;
+    rtlb->misses = 0;
+
+    if (!rtlb->entries) {
+        fprintf(stderr, "Failed to allocate memory for range TLB\n");
+        exit(1);
+    }
+
+    printf("Range TLB initialized with %u entries\n", rtlb->size);
+}
+
+void cleanup_range_tlb(RangeTLB *rtlb) {
+    if (rtlb->entries) {
+        free(rtlb->entries);
+        rtlb->entries = NULL;
+    }
+    rtlb->size = 0;
+}
+
+bool range_tlb_lookup(RangeTLB *rtlb, uint32_t virtual_page, uint32_t *physical_frame) {
+    rtlb->accesses++;
+
+    // Search all range entries
+    for (uint32_t i = 0; i < rtlb->size; i++) {
+        RangeTLBEntry *entry = &rtlb->entries[i];
+        if (entry->valid && virtual_page - entry->base_page < entry->num_pages) {
+            rtlb->hits++;
+            *physical_frame = entry->base_frame + (virtual_page - entry->base_page);
+            return true;
+        }
+    }
+
+    rtlb->misses++;
+    return false;
+}
+
+void range_tlb_insert(RangeTLB *rtlb, uint32_t base_page, uint32_t num_pages, uint32_t base_frame) {
+    uint32_t offset = base_frame - base_page;
+    uint32_t first = base_page;
+    uint32_t end = base_page + num_pages;
+    RangeTLBEntry *target = NULL;
+    bool merged = true;
+
+    // Merge every entry with the same mapping offset that overlaps or abuts
+    // the range, so one contiguous segment occupies a single entry. Growing
+    // the range can bring further entries into reach, so repeat until stable.
+    while (merged) {
+        merged = false;
+        for (uint32_t i = 0; i < rtlb->size; i++) {
+            RangeTLBEntry *entry = &rtlb->entries[i];
+            if (entry == target || !entry->valid || entry->base_frame - entry->base_page != offset ||
+                entry->base_page > end || entry->base_page + entry->num_pages < first) {
+                continue;
+            }
+
+            if (entry->base_page < first) {
+                first = entry->base_page;
+            }
+            if (entry->base_page + entry->num_pages > end) {
+                end = entry->base_page + entry->num_pages;
+            }
+
+            // The first merged entry holds the result, the others are redundant
+            if (target) {
+                entry->valid = false;
+            } else {
+                target = entry;
+            }
+            merged = true;
+        }
+    }
+
+    if (!target) {
+        // Use round-robin replacement policy
+        target = &rtlb->entries[rtlb->next_replace];
+        rtlb->next_replace = (rtlb->next_replace + 1) % rtlb->size;
+    }
+
+    target->valid = true;
+    target->base_page = first;
+    target->num_pages = end - first;
+    target->base_frame = first + offset;
+}
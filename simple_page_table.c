@@ -1,8 +1,14 @@
+#define _DEFAULT_SOURCE
+
 #include "vm_memory.h"
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 void init_simple_page_table(SimplePageTable *pt) {
     pt->size = NUM_PAGES;
     pt->entries = (PageTableEntry *)calloc(pt->size, sizeof(PageTableEntry));
+    pt->sparse = false;
     pt->accesses = 0;
     pt->hits = 0;
     pt->faults = 0;
@@ -15,13 +21,73 @@ void init_simple_page_table(SimplePageTable *pt) {
     printf("Simple page table initialized with %u entries\n", pt->size);
 }
 
+// Same flat layout and lookup as init_simple_page_table, but the entry array
+// is only reserved. Host pages are backed on first touch, so an instance
+// costs memory in proportion to the pages it has actually mapped.
+// Transparent huge pages are turned off for the region, since under THP
+// "always" a single touch would back a whole 2MB huge page.
+void init_simple_page_table_sparse(SimplePageTable *pt) {
+    pt->size = NUM_PAGES;
+    pt->entries = (PageTableEntry *)mmap(NULL, (size_t)pt->size * sizeof(PageTableEntry),
+                                         PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    pt->sparse = true;
+    pt->accesses = 0;
+    pt->hits = 0;
+    pt->faults = 0;
+    
+    if (pt->entries == MAP_FAILED) {
+        fprintf(stderr, "Failed to reserve memory for sparse simple page table\n");
+        exit(1);
+    }
+    
+    // EINVAL means the kernel was built without THP, so there is nothing to disable
+    if (madvise(pt->entries, (size_t)pt->size * sizeof(PageTableEntry), MADV_NOHUGEPAGE) != 0 &&
+        errno != EINVAL) {
+        fprintf(stderr, "Failed to disable huge pages for sparse simple page table\n");
+    }
+    
+    printf("Sparse simple page table initialized with %u entries\n", pt->size);
+}
+
 void cleanup_simple_page_table(SimplePageTable *pt) {
     if (pt->entries) {
-        free(pt->entries);
+        if (pt->sparse) {
+            munmap(pt->entries, (size_t)pt->size * sizeof(PageTableEntry));
+        } else {
+            free(pt->entries);
+        }
         pt->entries = NULL;
     }
 }
 
+// Host memory backing the entry array. A dense table is counted in full;
+// a sparse one is measured with mincore.
+size_t simple_page_table_resident_bytes(SimplePageTable *pt) {
+    size_t table_bytes = (size_t)pt->size * sizeof(PageTableEntry);
+    if (!pt->sparse) {
+        return table_bytes;
+    }
+    
+    size_t host_page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t host_pages = (table_bytes + host_page - 1) / host_page;
+    unsigned char *residency = (unsigned char *)malloc(host_pages);
+    if (!residency) {
+        fprintf(stderr, "Failed to allocate residency vector\n");
+        return 0;
+    }
+    
+    size_t resident = 0;
+    if (mincore(pt->entries, table_bytes, residency) == 0) {
+        for (size_t i = 0; i < host_pages; i++) {
+            resident += residency[i] & 1;
+        }
+    }
+    
+    free(residency);
+    return resident * host_page;
+}
+
 uint32_t translate_simple_page_table(SimplePageTable *pt, uint32_t virtual_addr, bool *fault) {
     uint32_t page_number = get_page_number(virtual_addr);
     uint32_t page_offset = get_page_offset(virtual_addr);
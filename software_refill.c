@@ -0,0 +1,104 @@
+#include "vm_memory.h"
+
+// Switch the MMU to software-managed TLB refill. table_size is the number of
+// TSB entries or hash slots the handler uses (power of two, 0 for none).
+void mmu_set_software_refill(MMU *mmu, TLBRefillHandler handler, const char *name, uint32_t table_size) {
+    if (table_size & (table_size - 1)) {
+        fprintf(stderr, "Software refill table size %u is not a power of two\n", table_size);
+        return;
+    }
+
+    // The hashed and TSB handlers index their table unconditionally
+    if ((handler == sw_refill_hashed || handler == sw_refill_tsb) && table_size == 0) {
+        fprintf(stderr, "Software refill handler %s needs a non-zero table size\n", name);
+        return;
+    }
+
+    cleanup_software_refill(&mmu->sw_refill);
+    memset(&mmu->sw_refill, 0, sizeof(SoftwareRefill));
+
+    if (table_size > 0) {
+        mmu->sw_refill.table = (SoftwareTranslation *)calloc(table_size, sizeof(SoftwareTranslation));
+        if (!mmu->sw_refill.table) {
+            fprintf(stderr, "Failed to allocate software refill table\n");
+            exit(1);
+        }
+    }
+
+    mmu->sw_refill.handler = handler;
+    mmu->sw_refill.handler_name = name;
+    mmu->sw_refill.table_size = table_size;
+    mmu->refill_mode = TLB_REFILL_SOFTWARE;
+
+    printf("Software TLB refill enabled with %s handler\n", name);
+}
+
+void cleanup_software_refill(SoftwareRefill *sw) {
+    if (sw->table) {
+        free(sw->table);
+        sw->table = NULL;
+    }
+}
+
+// Walk the two-level page table in software, mapping the page on a fault
+uint32_t sw_refill_linear(MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions) {
+    uint32_t physical_addr = translate_two_level_page_table(&mmu->page_table, virtual_addr, page_fault);
+    *instructions += SW_LINEAR_REFILL_INSTRUCTIONS;
+    return get_page_number(physical_addr);
+}
+
+// Open-addressed hash table of translations in front of the page table.
+// A lookup miss falls back to the software walk and caches the result.
+uint32_t sw_refill_hashed(MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions) {
+    SoftwareRefill *sw = &mmu->sw_refill;
+    uint32_t virtual_page = get_page_number(virtual_addr);
+    uint32_t mask = sw->table_size - 1;
+    uint32_t slot = (virtual_page ^ (virtual_page >> 10)) & mask;
+
+    *instructions += SW_HASH_BASE_INSTRUCTIONS;
+    for (uint32_t probe = 0; probe < sw->table_size; probe++) {
+        SoftwareTranslation *entry = &sw->table[slot];
+        if (!entry->valid) {
+            break;
+        }
+        if (entry->virtual_page == virtual_page) {
+            sw->table_hits++;
+            *page_fault = false;
+            return entry->physical_frame;
+        }
+        slot = (slot + 1) & mask;
+        *instructions += SW_HASH_PROBE_INSTRUCTIONS;
+    }
+
+    sw->table_misses++;
+    uint32_t physical_frame = sw_refill_linear(mmu, virtual_addr, page_fault, instructions);
+
+    // slot is the empty slot that ended the probe, or the home slot of a
+    // full table, which is then overwritten
+    sw->table[slot].valid = true;
+    sw->table[slot].virtual_page = virtual_page;
+    sw->table[slot].physical_frame = physical_frame;
+    return physical_frame;
+}
+
+// Direct-mapped translation storage buffer (SPARC-style TSB)
+uint32_t sw_refill_tsb(MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions) {
+    SoftwareRefill *sw = &mmu->sw_refill;
+    uint32_t virtual_page = get_page_number(virtual_addr);
+    SoftwareTranslation *entry = &sw->table[virtual_page & (sw->table_size - 1)];
+
+    *instructions += SW_TSB_HIT_INSTRUCTIONS;
+    if (entry->valid && entry->virtual_page == virtual_page) {
+        sw->table_hits++;
+        *page_fault = false;
+        return entry->physical_frame;
+    }
+
+    sw->table_misses++;
+    uint32_t physical_frame = sw_refill_linear(mmu, virtual_addr, page_fault, instructions);
+
+    entry->valid = true;
+    entry->virtual_page = virtual_page;
+    entry->physical_frame = physical_frame;
+    return physical_frame;
+}
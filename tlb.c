@@ -4,9 +4,11 @@ void init_tlb(TLB *tlb) {
     tlb->size = TLB_SIZE;
     tlb->entries = (TLBEntry *)calloc(tlb->size, sizeof(TLBEntry));
     tlb->next_replace = 0;
+    tlb->coalesce_span = 1;
     tlb->accesses = 0;
     tlb->hits = 0;
     tlb->misses = 0;
+    tlb->coalesced_fills = 0;
     
     if (!tlb->entries) {
         fprintf(stderr, "Failed to allocate memory for TLB\n");
@@ -26,6 +28,26 @@ void cleanup_tlb(TLB *tlb) {
 bool tlb_lookup(TLB *tlb, uint32_t virtual_page, uint32_t *physical_frame) {
     tlb->accesses++;
     
+    if (tlb->coalesce_span > 1) {
+        // Coalesced entries are tagged by the aligned group base page
+        uint32_t group_base = virtual_page & ~(tlb->coalesce_span - 1);
+        uint32_t bit = virtual_page - group_base;
+        
+        for (uint32_t i = 0; i < tlb->size; i++) {
+            TLBEntry *entry = &tlb->entries[i];
+            if (entry->valid && entry->virtual_page == group_base &&
+                (entry->coalesce_bitmap >> bit) & 1) {
+                tlb->hits++;
+                entry->referenced = true;
+                *physical_frame = entry->physical_frame + bit;
+                return true;
+            }
+        }
+        
+        tlb->misses++;
+        return false;
+    }
+    
     // Search all TLB entries
     for (uint32_t i = 0; i < tlb->size; i++) {
         TLBEntry *entry = &tlb->entries[i];
@@ -41,7 +63,68 @@ bool tlb_lookup(TLB *tlb, uint32_t virtual_page, uint32_t *physical_frame) {
     return false;
 }
 
+// Insert a coalesced entry for the aligned group containing virtual_page.
+// Bit i of bitmap means group page i maps to the frame at the same distance
+// from physical_frame as it is from virtual_page.
+void tlb_insert_coalesced(TLB *tlb, uint32_t virtual_page, uint32_t physical_frame, uint32_t bitmap) {
+    uint32_t group_base = virtual_page & ~(tlb->coalesce_span - 1);
+    uint32_t base_frame = physical_frame - (virtual_page - group_base);
+    
+    if (bitmap & (bitmap - 1)) {
+        tlb->coalesced_fills++;
+    }
+    
+    // Widen an existing entry for the same contiguous run rather than
+    // spending a second slot on it
+    for (uint32_t i = 0; i < tlb->size; i++) {
+        TLBEntry *entry = &tlb->entries[i];
+        if (entry->valid && entry->virtual_page == group_base && entry->physical_frame == base_frame) {
+            entry->coalesce_bitmap |= bitmap;
+            entry->referenced = true;
+            return;
+        }
+    }
+    
+    TLBEntry *entry = &tlb->entries[tlb->next_replace];
+    
+    entry->valid = true;
+    entry->virtual_page = group_base;
+    entry->physical_frame = base_frame;
+    entry->coalesce_bitmap = bitmap;
+    entry->referenced = true;
+    entry->dirty = false;
+    
+    tlb->next_replace = (tlb->next_replace + 1) % tlb->size;
+}
+
+// Switch between one-page entries (span 1) and coalesced entries covering
+// an aligned group of span pages. Existing entries are invalidated.
+void tlb_set_coalescing(TLB *tlb, uint32_t span) {
+    if (span == 0 || span > TLB_COALESCE_MAX_SPAN || (span & (span - 1)) != 0) {
+        fprintf(stderr, "Invalid TLB coalescing span %u (must be a power of two <= %d)\n",
+                span, TLB_COALESCE_MAX_SPAN);
+        return;
+    }
+    
+    tlb->coalesce_span = span;
+    tlb_invalidate_all(tlb);
+    printf("TLB coalescing span set to %u pages\n", span);
+}
+
+// Account for repeated hits on the entry matched by the preceding lookup.
+// The entry's referenced bit was already set by that lookup or insert.
+void tlb_record_hits(TLB *tlb, uint64_t count) {
+    tlb->accesses += count;
+    tlb->hits += count;
+}
+
 void tlb_insert(TLB *tlb, uint32_t virtual_page, uint32_t physical_frame) {
+    if (tlb->coalesce_span > 1) {
+        uint32_t bit = virtual_page & (tlb->coalesce_span - 1);
+        tlb_insert_coalesced(tlb, virtual_page, physical_frame, 1u << bit);
+        return;
+    }
+    
     // Use round-robin replacement policy
     TLBEntry *entry = &tlb->entries[tlb->next_replace];
     
@@ -63,14 +146,20 @@ void tlb_invalidate_all(TLB *tlb) {
 
 void tlb_print_contents(TLB *tlb) {
     printf("\nTLB Contents:\n");
-    printf("Index | Valid | Virtual Page | Physical Frame | Referenced\n");
-    printf("------|-------|-------------|----------------|-----------\n");
+    printf("Index | Valid | Virtual Page | Physical Frame | Referenced%s\n",
+           tlb->coalesce_span > 1 ? " | Bitmap" : "");
+    printf("------|-------|-------------|----------------|-----------%s\n",
+           tlb->coalesce_span > 1 ? "|-----------" : "");
     
     for (uint32_t i = 0; i < tlb->size; i++) {
         TLBEntry *entry = &tlb->entries[i];
-        printf("  %2u  |   %c   |   0x%06X   |     0x%04X     |     %c\n",
+        printf("  %2u  |   %c   |   0x%06X   |     0x%04X     |     %c",
                i, entry->valid ? 'Y' : 'N', entry->virtual_page, 
                entry->physical_frame, entry->referenced ? 'Y' : 'N');
+        if (tlb->coalesce_span > 1) {
+            printf("      | 0x%08X", entry->coalesce_bitmap);
+        }
+        printf("\n");
     }
     printf("\n");
 }
\ No newline at end of file
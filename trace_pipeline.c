@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "vm_memory.h"
+#include <pthread.h>
+#include <sched.h>
+
+// Producer-side decoding state
+typedef struct {
+    TraceRing *ring;
+    TraceSource *source;
+    TracePipelineStats *stats;
+    FILE *file;
+    uint64_t produced;
+    uint32_t rng_state;
+    uint32_t sequential_base;
+    uint32_t hot_region_start;
+} TraceProducer;
+
+// Monotonic wall-clock time, for comparing serial and pipelined replay
+double wall_clock_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// xorshift32, so generated traces are reproducible from the seed
+static uint32_t trace_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t generate_address(TraceProducer *producer, uint64_t index) {
+    uint32_t *rng = &producer->rng_state;
+
+    switch (producer->source->locality) {
+        case 1: // Sequential access
+            return producer->sequential_base + (uint32_t)index * 4;
+
+        case 2: // Locality of reference (80/20 rule)
+            if (trace_rand(rng) % 100 < 80) {
+                return producer->hot_region_start + trace_rand(rng) % (uint32_t)(VIRTUAL_ADDRESS_SPACE_SIZE / 20);
+            }
+            return trace_rand(rng);
+
+        default: // Random access
+            return trace_rand(rng);
+    }
+}
+
+// Decode up to one batch from the source. Returns 0 at end of trace.
+static int decode_batch(TraceProducer *producer, uint32_t *addresses) {
+    TraceSource *source = producer->source;
+    uint64_t limit = TRACE_BATCH_SIZE;
+    if (source->count > 0 && source->count - producer->produced < limit) {
+        limit = source->count - producer->produced;
+    }
+
+    int count = 0;
+    switch (source->type) {
+        case TRACE_SOURCE_TEXT: {
+            uint32_t addr;
+            while ((uint64_t)count < limit && fscanf(producer->file, " 0x%X", &addr) == 1) {
+                addresses[count++] = addr;
+            }
+            break;
+        }
+
+        case TRACE_SOURCE_BINARY:
+            count = (int)fread(addresses, sizeof(uint32_t), limit, producer->file);
+            break;
+
+        case TRACE_SOURCE_GENERATED:
+            while ((uint64_t)count < limit) {
+                addresses[count] = generate_address(producer, producer->produced + count);
+                count++;
+            }
+            break;
+    }
+
+    producer->produced += count;
+    return count;
+}
+
+static void *trace_producer_main(void *arg) {
+    TraceProducer *producer = (TraceProducer *)arg;
+    TraceRing *ring = producer->ring;
+    uint64_t head = 0;
+
+    for (;;) {
+        // Backpressure: wait for the consumer to free a slot
+        while (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == TRACE_RING_SLOTS) {
+            producer->stats->producer_stalls++;
+            sched_yield();
+        }
+
+        TraceBatch *batch = &ring->slots[head & (TRACE_RING_SLOTS - 1)];
+        double start = wall_clock_seconds();
+        batch->count = decode_batch(producer, batch->addresses);
+        producer->stats->decode_seconds += wall_clock_seconds() - start;
+
+        if (batch->count == 0) {
+            break;
+        }
+
+        head++;
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&ring->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void run_simulation_pipelined(MMU *mmu, TraceSource *source, MemoryStats *stats, TracePipelineStats *pipeline_stats) {
+    memset(pipeline_stats, 0, sizeof(TracePipelineStats));
+
+    TraceProducer producer;
+    memset(&producer, 0, sizeof(TraceProducer));
+    producer.source = source;
+    producer.stats = pipeline_stats;
+
+    if (source->type == TRACE_SOURCE_GENERATED) {
+        if (source->count == 0) {
+            fprintf(stderr, "Generated trace source needs a non-zero count\n");
+            memset(stats, 0, sizeof(MemoryStats));
+            return;
+        }
+        producer.rng_state = source->seed ? source->seed : 1;
+        if (source->locality == 1) {
+            // A sequential trace with a 4-byte stride must fit in the address space
+            if (source->count > VIRTUAL_ADDRESS_SPACE_SIZE / 4) {
+                fprintf(stderr, "Sequential trace of %lu addresses exceeds the %llu-byte address space\n",
+                        source->count, (unsigned long long)VIRTUAL_ADDRESS_SPACE_SIZE);
+                memset(stats, 0, sizeof(MemoryStats));
+                return;
+            }
+            producer.sequential_base = (uint32_t)(trace_rand(&producer.rng_state) %
+                                                  (VIRTUAL_ADDRESS_SPACE_SIZE - source->count * 4 + 1));
+        }
+        producer.hot_region_start = trace_rand(&producer.rng_state) % (uint32_t)(VIRTUAL_ADDRESS_SPACE_SIZE / 4);
+    } else {
+        producer.file = fopen(source->filename, source->type == TRACE_SOURCE_BINARY ? "rb" : "r");
+        if (!producer.file) {
+            fprintf(stderr, "Failed to open file %s for reading\n", source->filename);
+            memset(stats, 0, sizeof(MemoryStats));
+            return;
+        }
+    }
+
+    TraceRing *ring = (TraceRing *)calloc(1, sizeof(TraceRing));
+    if (!ring) {
+        fprintf(stderr, "Failed to allocate trace ring buffer\n");
+        exit(1);
+    }
+    producer.ring = ring;
+
+    printf("Running pipelined simulation (%d slots of %d addresses)...\n", TRACE_RING_SLOTS, TRACE_BATCH_SIZE);
+
+    double wall_start = wall_clock_seconds();
+    pthread_t producer_thread;
+    if (pthread_create(&producer_thread, NULL, trace_producer_main, &producer) != 0) {
+        fprintf(stderr, "Failed to start trace producer thread\n");
+        exit(1);
+    }
+
+    SimulationRun run;
+    simulation_begin(mmu, &run);
+
+    uint64_t tail = 0;
+    for (;;) {
+        if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+            // The producer may have published a last batch before finishing
+            if (__atomic_load_n(&ring->done, __ATOMIC_ACQUIRE) &&
+                tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            pipeline_stats->consumer_stalls++;
+            sched_yield();
+            continue;
+        }
+
+        TraceBatch *batch = &ring->slots[tail & (TRACE_RING_SLOTS - 1)];
+        double start = wall_clock_seconds();
+        simulation_process(mmu, &run, batch->addresses, batch->count);
+        pipeline_stats->simulate_seconds += wall_clock_seconds() - start;
+        pipeline_stats->batches++;
+        pipeline_stats->addresses += batch->count;
+
+        tail++;
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+
+    pthread_join(producer_thread, NULL);
+    pipeline_stats->wall_seconds = wall_clock_seconds() - wall_start;
+
+    simulation_finish(mmu, &run, stats);
+
+    if (producer.file) {
+        fclose(producer.file);
+    }
+    free(ring);
+
+    printf("Pipelined simulation completed.\n");
+}
+
+void print_pipeline_statistics(TracePipelineStats *pipeline_stats) {
+    printf("\n=== Pipeline Statistics ===\n");
+    printf("Batches: %lu, Addresses: %lu\n", pipeline_stats->batches, pipeline_stats->addresses);
+    printf("Producer Stalls (ring full): %lu\n", pipeline_stats->producer_stalls);
+    printf("Consumer Stalls (ring empty): %lu\n", pipeline_stats->consumer_stalls);
+    printf("Decode Time: %.4f s\n", pipeline_stats->decode_seconds);
+    printf("Simulate Time: %.4f s\n", pipeline_stats->simulate_seconds);
+    printf("Wall Time: %.4f s\n", pipeline_stats->wall_seconds);
+    printf("==============================\n");
+}
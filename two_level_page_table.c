@@ -2,6 +2,7 @@
 
 void init_two_level_page_table(TwoLevelPageTable *pt) {
     pt->l1_size = L1_SIZE;
+    pt->frame_allocator = NULL;
     pt->l1_table = (PageTableEntry **)calloc(pt->l1_size, sizeof(PageTableEntry *));
     pt->l1_valid = (bool *)calloc(pt->l1_size, sizeof(bool));
     pt->accesses = 0;
@@ -18,9 +19,17 @@ void init_two_level_page_table(TwoLevelPageTable *pt) {
 
 void cleanup_two_level_page_table(TwoLevelPageTable *pt) {
     if (pt->l1_table) {
-        // Free all allocated L2 tables
+        // Free all allocated L2 tables, returning buddy-allocated frames
         for (uint32_t i = 0; i < pt->l1_size; i++) {
             if (pt->l1_valid[i] && pt->l1_table[i]) {
+                if (pt->frame_allocator) {
+                    for (uint32_t j = 0; j < L2_SIZE; j++) {
+                        PageTableEntry *entry = &pt->l1_table[i][j];
+                        if (entry->valid && entry->frame_owned) {
+                            buddy_free(pt->frame_allocator, entry->frame_number, 0);
+                        }
+                    }
+                }
                 free(pt->l1_table[i]);
             }
         }
@@ -34,6 +43,28 @@ void cleanup_two_level_page_table(TwoLevelPageTable *pt) {
     }
 }
 
+// Allocate a physical frame for a newly mapped page. Without a buddy
+// allocator frames are handed out round-robin from the caller's counter.
+// With one, frames come from the allocator and the entry owns them; if it
+// is exhausted the page aliases an existing frame, as the round-robin
+// scheme does, and the entry does not own it.
+static void allocate_frame(TwoLevelPageTable *pt, PageTableEntry *entry, uint32_t *next_frame) {
+    entry->frame_owned = false;
+    
+    if (!pt->frame_allocator) {
+        entry->frame_number = (*next_frame)++ % NUM_PHYSICAL_FRAMES;
+        return;
+    }
+    
+    uint32_t frame = buddy_alloc(pt->frame_allocator, 0);
+    if (frame == BUDDY_NO_FRAME) {
+        entry->frame_number = (*next_frame)++ % pt->frame_allocator->num_frames;
+        return;
+    }
+    entry->frame_number = frame;
+    entry->frame_owned = true;
+}
+
 uint32_t translate_two_level_page_table(TwoLevelPageTable *pt, uint32_t virtual_addr, bool *fault) {
     uint32_t l1_index = get_l1_index(virtual_addr);
     uint32_t l2_index = get_l2_index(virtual_addr);
@@ -57,11 +88,10 @@ uint32_t translate_two_level_page_table(TwoLevelPageTable *pt, uint32_t virtual_
         // Set up the new page entry
         PageTableEntry *entry = &pt->l1_table[l1_index][l2_index];
         static uint32_t next_frame = 0;
-        entry->frame_number = next_frame % NUM_PHYSICAL_FRAMES;
+        allocate_frame(pt, entry, &next_frame);
         entry->valid = true;
         entry->referenced = true;
         entry->dirty = false;
-        next_frame++;
         
         return (entry->frame_number << PAGE_OFFSET_BITS) | page_offset;
     }
@@ -75,11 +105,10 @@ uint32_t translate_two_level_page_table(TwoLevelPageTable *pt, uint32_t virtual_
         
         // Allocate physical frame for this page
         static uint32_t next_frame = 0;
-        entry->frame_number = next_frame % NUM_PHYSICAL_FRAMES;
+        allocate_frame(pt, entry, &next_frame);
         entry->valid = true;
         entry->referenced = true;
         entry->dirty = false;
-        next_frame++;
         
         return (entry->frame_number << PAGE_OFFSET_BITS) | page_offset;
     }
@@ -89,4 +118,23 @@ uint32_t translate_two_level_page_table(TwoLevelPageTable *pt, uint32_t virtual_
     entry->referenced = true;
     
     return (entry->frame_number << PAGE_OFFSET_BITS) | page_offset;
-}
\ No newline at end of file
+}
+
+// Look up an existing mapping without allocating, faulting or touching the
+// access statistics. Used to detect physical contiguity at TLB fill time.
+bool two_level_page_table_probe(TwoLevelPageTable *pt, uint32_t virtual_page, uint32_t *frame) {
+    uint32_t l1_index = (virtual_page >> L2_BITS) & L1_INDEX_MASK;
+    uint32_t l2_index = virtual_page & L2_INDEX_MASK;
+    
+    if (!pt->l1_valid[l1_index]) {
+        return false;
+    }
+    
+    PageTableEntry *entry = &pt->l1_table[l1_index][l2_index];
+    if (!entry->valid) {
+        return false;
+    }
+    
+    *frame = entry->frame_number;
+    return true;
+}
@@ -81,36 +81,96 @@ void generate_address_trace(uint32_t *addresses, int count, int locality) {
     }
 }
 
-void run_simulation(MMU *mmu, uint32_t *addresses, int count, MemoryStats *stats) {
-    memset(stats, 0, sizeof(MemoryStats));
+void simulation_begin(MMU *mmu, SimulationRun *run) {
+    run->start_cycles = mmu->total_cycles;
+    run->start_tlb_hits = mmu->tlb.hits;
+    run->start_page_faults = mmu->page_table.faults;
+    run->processed = 0;
+    run->next_progress = 10000;
     
-    printf("Running simulation with %d memory accesses...\n", count);
-    
-    uint64_t start_cycles = mmu->total_cycles;
-    uint64_t start_tlb_hits = mmu->tlb.hits;
-    uint64_t start_page_faults = mmu->page_table.faults;
+    if (mmu->interval_stats) {
+        interval_stats_begin(mmu->interval_stats, mmu);
+    }
+}
+
+void simulation_process(MMU *mmu, SimulationRun *run, uint32_t *addresses, int count) {
+    IntervalStats *intervals = mmu->interval_stats;
     
-    for (int i = 0; i < count; i++) {
+    int i = 0;
+    while (i < count) {
+        uint32_t virtual_page = get_page_number(addresses[i]);
+        
+        // In coalescing mode, every reference after the first in a same-page
+        // run is a guaranteed TLB hit on the entry the first one left behind
+        int run_length = 1;
+        if (mmu->coalesce_page_runs) {
+            while (i + run_length < count && get_page_number(addresses[i + run_length]) == virtual_page) {
+                run_length++;
+            }
+        }
+        
         uint32_t physical_addr = mmu_translate(mmu, addresses[i]);
         (void)physical_addr; // Suppress unused variable warning
         
+        if (intervals) {
+            interval_stats_record(intervals, mmu, virtual_page, 1);
+            
+            // Split the hit extension at interval boundaries so snapshots
+            // match per-reference replay exactly
+            uint64_t remaining = run_length - 1;
+            while (remaining > 0) {
+                uint64_t batch = interval_stats_hit_budget(intervals, mmu);
+                if (batch > remaining) {
+                    batch = remaining;
+                }
+                mmu_extend_tlb_hit(mmu, batch);
+                interval_stats_record(intervals, mmu, virtual_page, batch);
+                remaining -= batch;
+            }
+        } else if (run_length > 1) {
+            mmu_extend_tlb_hit(mmu, run_length - 1);
+        }
+        
+        i += run_length;
+        run->processed += run_length;
+        
         // Print progress every 10000 accesses
-        if (i % 10000 == 0 && i > 0) {
-            printf("  Processed %d accesses...\n", i);
+        while (run->next_progress < run->processed) {
+            printf("  Processed %lu accesses...\n", run->next_progress);
+            run->next_progress += 10000;
         }
     }
+}
+
+void simulation_finish(MMU *mmu, SimulationRun *run, MemoryStats *stats) {
+    memset(stats, 0, sizeof(MemoryStats));
+    
+    if (mmu->interval_stats) {
+        interval_stats_finish(mmu->interval_stats, mmu);
+    }
     
     // Calculate statistics
-    stats->total_accesses = count;
-    stats->tlb_hits = mmu->tlb.hits - start_tlb_hits;
+    stats->total_accesses = run->processed;
+    stats->tlb_hits = mmu->tlb.hits - run->start_tlb_hits;
     stats->tlb_misses = stats->total_accesses - stats->tlb_hits;
-    stats->page_faults = mmu->page_table.faults - start_page_faults;
+    stats->page_faults = mmu->page_table.faults - run->start_page_faults;
     stats->page_hits = stats->total_accesses - stats->page_faults;
-    stats->total_cycles = mmu->total_cycles - start_cycles;
+    stats->total_cycles = mmu->total_cycles - run->start_cycles;
+    
+    if (stats->total_accesses > 0) {
+        stats->tlb_hit_rate = (double)stats->tlb_hits / stats->total_accesses * 100;
+        stats->page_hit_rate = (double)stats->page_hits / stats->total_accesses * 100;
+        stats->avg_access_time = (double)stats->total_cycles / stats->total_accesses;
+    }
+}
+
+void run_simulation(MMU *mmu, uint32_t *addresses, int count, MemoryStats *stats) {
+    printf("Running simulation with %d memory accesses...\n", count);
     
-    stats->tlb_hit_rate = (double)stats->tlb_hits / stats->total_accesses * 100;
-    stats->page_hit_rate = (double)stats->page_hits / stats->total_accesses * 100;
-    stats->avg_access_time = (double)stats->total_cycles / stats->total_accesses;
+    SimulationRun run;
+    simulation_begin(mmu, &run);
+    simulation_process(mmu, &run, addresses, count);
+    simulation_finish(mmu, &run, stats);
     
     printf("Simulation completed.\n");
 }
@@ -142,6 +202,20 @@ void save_addresses_to_file(uint32_t *addresses, int count, const char *filename
     printf("Saved %d addresses to %s\n", count, filename);
 }
 
+void save_addresses_to_binary_file(uint32_t *addresses, int count, const char *filename) {
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Failed to open file %s for writing\n", filename);
+        return;
+    }
+    
+    // Raw host-endian 32-bit addresses, as read by TRACE_SOURCE_BINARY
+    size_t written = fwrite(addresses, sizeof(uint32_t), count, file);
+    
+    fclose(file);
+    printf("Saved %zu addresses to %s\n", written, filename);
+}
+
 void load_addresses_from_file(uint32_t *addresses, int *count, const char *filename) {
     FILE *file = fopen(filename, "r");
     if (!file) {
@@ -152,7 +226,7 @@ void load_addresses_from_file(uint32_t *addresses, int *count, const char *filen
     
     int i = 0;
     uint32_t addr;
-    while (fscanf(file, "0x%X", &addr) == 1 && i < *count) {
+    while (i < *count && fscanf(file, " 0x%X", &addr) == 1) {
         addresses[i] = addr;
         i++;
     }
@@ -22,6 +22,31 @@
 #define PAGE_TABLE_ACCESS_TIME 10  // cycles
 #define PAGE_FAULT_TIME 1000       // cycles
 
+// Coalesced / Range TLB Configuration
+#define TLB_COALESCE_MAX_SPAN 32   // Max pages per coalesced entry (bitmap width)
+#define RANGE_TLB_SIZE 4
+#define RANGE_TLB_HIT_TIME 2       // cycles
+#define RANGE_TLB_MAX_SCAN 512     // Pages scanned each way for contiguity on a miss
+
+// Software-Managed TLB Configuration
+#define SW_TRAP_ENTRY_TIME 20               // cycles to take the refill trap
+#define SW_TRAP_EXIT_TIME 10                // cycles to return from it
+#define SW_HANDLER_CYCLES_PER_INSTRUCTION 1
+#define SW_LINEAR_REFILL_INSTRUCTIONS 12    // Software walk of the two-level table
+#define SW_HASH_BASE_INSTRUCTIONS 10        // Hash computation and first probe
+#define SW_HASH_PROBE_INSTRUCTIONS 4        // Each additional probe
+#define SW_HASH_BUCKETS 4096
+#define SW_TSB_HIT_INSTRUCTIONS 8           // Index, tag compare and TLB write
+#define SW_TSB_SIZE 512
+
+// Pipelined Trace Ingestion Configuration
+#define TRACE_BATCH_SIZE 4096       // Addresses per ring slot
+#define TRACE_RING_SLOTS 8          // Power of two
+
+// Buddy Allocator Configuration
+#define BUDDY_MAX_ORDER 31         // Largest block is 2^31 frames
+#define BUDDY_NO_FRAME UINT32_MAX  // Returned when an allocation fails
+
 // 2-Level Page Table Configuration
 #define L1_BITS 10        // First level page table bits
 #define L2_BITS 10        // Second level page table bits
@@ -40,6 +65,7 @@ typedef struct {
     uint32_t frame_number;
     bool referenced;
     bool dirty;
+    bool frame_owned;            // Frame came from a buddy allocator, released on cleanup
 } PageTableEntry;
 
 // TLB Entry
@@ -47,24 +73,53 @@ typedef struct {
     bool valid;
     uint32_t virtual_page;
     uint32_t physical_frame;
+    uint32_t coalesce_bitmap;    // Pages of the aligned group mapped (coalesced mode)
     bool referenced;
     bool dirty;
 } TLBEntry;
 
+// Range TLB Entry, maps [base_page, base_page + num_pages) contiguously
+typedef struct {
+    bool valid;
+    uint32_t base_page;
+    uint32_t num_pages;
+    uint32_t base_frame;
+} RangeTLBEntry;
+
 // Simple Direct-Mapped Page Table
 typedef struct {
     PageTableEntry *entries;
     uint32_t size;
+    bool sparse;                 // Entries reserved with mmap, populated on first touch
     uint64_t accesses;
     uint64_t hits;
     uint64_t faults;
 } SimplePageTable;
 
+// Buddy-system physical frame allocator
+typedef struct {
+    uint32_t num_frames;
+    uint32_t max_order;                       // Largest order that fits num_frames
+    uint32_t free_head[BUDDY_MAX_ORDER + 1];  // First free block of each order
+    uint32_t free_blocks[BUDDY_MAX_ORDER + 1];
+    uint32_t *next_free;                      // Free-list links, indexed by block start frame
+    uint32_t *prev_free;
+    uint8_t *free_order;                      // Order of the free block starting at a frame, or 0xFF
+    uint8_t *alloc_order;                     // Order of the allocated block starting at a frame, or 0xFF
+    uint32_t free_frames;
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t splits;
+    uint64_t merges;
+    uint64_t failed_allocations;
+} BuddyAllocator;
+
 // Two-Level Page Table
 typedef struct {
     PageTableEntry **l1_table;  // Array of pointers to L2 tables
     bool *l1_valid;              // Valid bits for L1 entries
     uint32_t l1_size;
+    BuddyAllocator *frame_allocator; // NULL = round-robin over NUM_PHYSICAL_FRAMES
     uint64_t accesses;
     uint64_t hits;
     uint64_t faults;
@@ -75,19 +130,108 @@ typedef struct {
     TLBEntry *entries;
     uint32_t size;
     uint32_t next_replace;       // For round-robin replacement
+    uint32_t coalesce_span;      // Pages per entry, 1 = no coalescing
     uint64_t accesses;
     uint64_t hits;
     uint64_t misses;
+    uint64_t coalesced_fills;    // Fills that mapped more than one page
 } TLB;
 
-// Combined Memory Management Unit
+// Range TLB Structure, consulted after a TLB miss
+typedef struct {
+    RangeTLBEntry *entries;
+    uint32_t size;               // 0 = disabled
+    uint32_t next_replace;
+    uint64_t accesses;
+    uint64_t hits;
+    uint64_t misses;
+} RangeTLB;
+
+// Snapshot of MMU behaviour over one statistics interval
 typedef struct {
+    uint64_t interval_index;
+    uint64_t first_access;       // Global index of the first reference in the interval
+    uint64_t accesses;
+    uint64_t tlb_hits;
+    uint64_t tlb_misses;
+    uint64_t page_walks;
+    uint64_t page_faults;
+    uint64_t cycles;
+    uint32_t working_set_pages;  // Distinct pages referenced in the interval
+    double tlb_hit_rate;
+    double avg_access_time;
+} IntervalSample;
+
+// Interval statistics collector
+typedef struct {
+    uint64_t interval_accesses;  // Snapshot every N references (0 = disabled)
+    uint64_t interval_cycles;    // Snapshot every N cycles (0 = disabled)
+    IntervalSample *samples;
+    uint32_t num_samples;
+    uint32_t capacity;
+    uint32_t *page_epoch;         // Interval (+1) in which each page was last seen
+    uint32_t *page_access_counts; // Per-page heat map, NULL when disabled
+    
+    // State of the interval currently being collected
+    uint64_t total_accesses;
+    uint64_t window_accesses;
+    uint64_t window_access_limit;
+    uint64_t next_cycle_boundary;
+    uint32_t window_working_set;
+    uint64_t base_tlb_hits;
+    uint64_t base_tlb_misses;
+    uint64_t base_page_walks;
+    uint64_t base_page_faults;
+    uint64_t base_cycles;
+} IntervalStats;
+
+// TLB miss handling
+typedef enum {
+    TLB_REFILL_HARDWARE,         // Hardware page walker
+    TLB_REFILL_SOFTWARE          // Trap to a software refill handler
+} TLBRefillMode;
+
+struct MMU;
+
+// Software refill handler. Resolves virtual_addr to a physical frame, setting
+// page_fault if the page had to be mapped and instructions to the number of
+// handler instructions executed.
+typedef uint32_t (*TLBRefillHandler)(struct MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions);
+
+// Translation cached by a software refill handler (TSB entry or hash slot)
+typedef struct {
+    bool valid;
+    uint32_t virtual_page;
+    uint32_t physical_frame;
+} SoftwareTranslation;
+
+// Software refill state and cost accounting
+typedef struct {
+    TLBRefillHandler handler;
+    const char *handler_name;
+    SoftwareTranslation *table;  // Handler-private TSB or hash table, may be NULL
+    uint32_t table_size;
+    uint64_t traps;
+    uint64_t trap_cycles;        // Trap entry and exit overhead
+    uint64_t handler_instructions;
+    uint64_t handler_cycles;
+    uint64_t table_hits;
+    uint64_t table_misses;
+} SoftwareRefill;
+
+// Combined Memory Management Unit
+typedef struct MMU {
     TLB tlb;
+    RangeTLB range_tlb;
     TwoLevelPageTable page_table;
     uint32_t *physical_memory;
     bool *frame_allocated;
     uint32_t next_free_frame;
     uint64_t total_cycles;
+    IntervalStats *interval_stats; // Optional collector, NULL when disabled
+    bool coalesce_page_runs;       // Replay runs of same-page references as one translation
+    TLBRefillMode refill_mode;
+    SoftwareRefill sw_refill;
 } MMU;
 
 // Statistics structure
@@ -103,28 +247,125 @@ typedef struct {
     double avg_access_time;
 } MemoryStats;
 
+// Baseline and progress of a simulation that is fed in batches
+typedef struct {
+    uint64_t start_cycles;
+    uint64_t start_tlb_hits;
+    uint64_t start_page_faults;
+    uint64_t processed;
+    uint64_t next_progress;
+} SimulationRun;
+
+// Where a pipelined replay reads its addresses from
+typedef enum {
+    TRACE_SOURCE_TEXT,           // One 0x%08X address per line
+    TRACE_SOURCE_BINARY,         // Raw host-endian uint32_t addresses
+    TRACE_SOURCE_GENERATED       // Synthesized on the producer thread
+} TraceSourceType;
+
+typedef struct {
+    TraceSourceType type;
+    const char *filename;        // Text and binary sources
+    int locality;                // Generated source, same patterns as generate_address_trace
+    uint32_t seed;               // Generated source
+    uint64_t count;              // Addresses to replay, 0 = whole file
+} TraceSource;
+
+// Fixed-size batch of decoded addresses
+typedef struct {
+    uint32_t addresses[TRACE_BATCH_SIZE];
+    int count;
+} TraceBatch;
+
+// Lock-free single-producer/single-consumer ring of batches. head and tail
+// are free-running counters kept on separate cache lines.
+typedef struct {
+    TraceBatch slots[TRACE_RING_SLOTS];
+    uint64_t head;               // Written by the producer only
+    char head_pad[64 - sizeof(uint64_t)];
+    uint64_t tail;               // Written by the consumer only
+    char tail_pad[64 - sizeof(uint64_t)];
+    bool done;                   // Producer has published its last batch
+} TraceRing;
+
+// Pipelined replay counters
+typedef struct {
+    uint64_t batches;
+    uint64_t addresses;
+    uint64_t producer_stalls;    // Yields while the ring was full (backpressure)
+    uint64_t consumer_stalls;    // Yields while the ring was empty
+    double decode_seconds;       // Producer time spent decoding
+    double simulate_seconds;     // Consumer time spent simulating
+    double wall_seconds;
+} TracePipelineStats;
+
 // Function declarations
 void init_simple_page_table(SimplePageTable *pt);
+void init_simple_page_table_sparse(SimplePageTable *pt);
+size_t simple_page_table_resident_bytes(SimplePageTable *pt);
 void cleanup_simple_page_table(SimplePageTable *pt);
 uint32_t translate_simple_page_table(SimplePageTable *pt, uint32_t virtual_addr, bool *fault);
 
 void init_two_level_page_table(TwoLevelPageTable *pt);
 void cleanup_two_level_page_table(TwoLevelPageTable *pt);
 uint32_t translate_two_level_page_table(TwoLevelPageTable *pt, uint32_t virtual_addr, bool *fault);
+bool two_level_page_table_probe(TwoLevelPageTable *pt, uint32_t virtual_page, uint32_t *frame);
+
+void init_buddy_allocator(BuddyAllocator *ba, uint32_t num_frames);
+void cleanup_buddy_allocator(BuddyAllocator *ba);
+uint32_t buddy_alloc(BuddyAllocator *ba, uint32_t order);
+void buddy_free(BuddyAllocator *ba, uint32_t frame, uint32_t order);
+uint32_t buddy_largest_free_order(BuddyAllocator *ba);
+double buddy_unusable_index(BuddyAllocator *ba, uint32_t order);
+void buddy_print_stats(BuddyAllocator *ba);
 
 void init_tlb(TLB *tlb);
 void cleanup_tlb(TLB *tlb);
 bool tlb_lookup(TLB *tlb, uint32_t virtual_page, uint32_t *physical_frame);
 void tlb_insert(TLB *tlb, uint32_t virtual_page, uint32_t physical_frame);
+void tlb_insert_coalesced(TLB *tlb, uint32_t virtual_page, uint32_t physical_frame, uint32_t bitmap);
+void tlb_set_coalescing(TLB *tlb, uint32_t span);
+void tlb_record_hits(TLB *tlb, uint64_t count);
 void tlb_invalidate_all(TLB *tlb);
 void tlb_print_contents(TLB *tlb);
 
+void init_range_tlb(RangeTLB *rtlb, uint32_t size);
+void cleanup_range_tlb(RangeTLB *rtlb);
+bool range_tlb_lookup(RangeTLB *rtlb, uint32_t virtual_page, uint32_t *physical_frame);
+void range_tlb_insert(RangeTLB *rtlb, uint32_t base_page, uint32_t num_pages, uint32_t base_frame);
+
 void init_mmu(MMU *mmu);
 void cleanup_mmu(MMU *mmu);
 uint32_t mmu_translate(MMU *mmu, uint32_t virtual_addr);
+void mmu_extend_tlb_hit(MMU *mmu, uint64_t count);
+void mmu_attach_frame_allocator(MMU *mmu, BuddyAllocator *allocator);
+void mmu_print_stats(MMU *mmu);
+
+void mmu_set_software_refill(MMU *mmu, TLBRefillHandler handler, const char *name, uint32_t table_size);
+void cleanup_software_refill(SoftwareRefill *sw);
+uint32_t sw_refill_linear(MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions);
+uint32_t sw_refill_hashed(MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions);
+uint32_t sw_refill_tsb(MMU *mmu, uint32_t virtual_addr, bool *page_fault, uint32_t *instructions);
+
+void init_interval_stats(IntervalStats *is, uint64_t interval_accesses, uint64_t interval_cycles, bool heat_map);
+void cleanup_interval_stats(IntervalStats *is);
+void interval_stats_begin(IntervalStats *is, MMU *mmu);
+void interval_stats_record(IntervalStats *is, MMU *mmu, uint32_t virtual_page, uint64_t count);
+uint64_t interval_stats_hit_budget(IntervalStats *is, MMU *mmu);
+void interval_stats_finish(IntervalStats *is, MMU *mmu);
+void interval_stats_print(IntervalStats *is);
+void interval_stats_export_csv(IntervalStats *is, const char *filename);
+void interval_stats_export_json(IntervalStats *is, const char *filename);
+void interval_stats_export_heat_map(IntervalStats *is, const char *filename);
 
 void generate_address_trace(uint32_t *addresses, int count, int locality);
 void run_simulation(MMU *mmu, uint32_t *addresses, int count, MemoryStats *stats);
+void simulation_begin(MMU *mmu, SimulationRun *run);
+void simulation_process(MMU *mmu, SimulationRun *run, uint32_t *addresses, int count);
+void simulation_finish(MMU *mmu, SimulationRun *run, MemoryStats *stats);
+void run_simulation_pipelined(MMU *mmu, TraceSource *source, MemoryStats *stats, TracePipelineStats *pipeline_stats);
+void print_pipeline_statistics(TracePipelineStats *pipeline_stats);
+double wall_clock_seconds(void);
 void print_statistics(MemoryStats *stats, const char *test_name);
 
 // Utility functions
@@ -134,6 +375,7 @@ uint32_t get_l1_index(uint32_t virtual_addr);
 uint32_t get_l2_index(uint32_t virtual_addr);
 void print_address_breakdown(uint32_t virtual_addr);
 void save_addresses_to_file(uint32_t *addresses, int count, const char *filename);
+void save_addresses_to_binary_file(uint32_t *addresses, int count, const char *filename);
 void load_addresses_from_file(uint32_t *addresses, int *count, const char *filename);
 
 #endif // VM_MEMORY_H
\ No newline at end of file